@@ -0,0 +1,152 @@
+/****************************************************************************
+ * Analysis of electrons in jets 							                *
+ * Copyright (C) 2015  Markus Fasel, Lawrence Berkeley National Laboratory  *
+ *                                                                          *
+ * This program is free software: you can redistribute it and/or modify     *
+ * it under the terms of the GNU General Public License as published by     *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful,          *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ * GNU General Public License for more details.                             *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License        *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ ****************************************************************************/
+#include "jettree/JetTreeCompactData.h"
+#include "jettree/JetTreeData.h"
+
+#include <TDatabasePDG.h>
+#include <TParticlePDG.h>
+
+#include <cmath>
+#include <cstdlib>
+
+JetTreeQuantization::JetTreeQuantization(int ptbits, int anglebits):
+		fPtMantissaBits(0),
+		fAngleFractionBits(0)
+{
+	SetPtMantissaBits(ptbits);
+	SetAngleFractionBits(anglebits);
+}
+
+void JetTreeQuantization::SetPtMantissaBits(int nbits){
+	fPtMantissaBits = nbits < 1 ? 1 : (nbits > kMaxPtBits ? kMaxPtBits : nbits);
+}
+
+void JetTreeQuantization::SetAngleFractionBits(int nbits){
+	fAngleFractionBits = nbits < 0 ? 0 : (nbits > kMaxAngleBits ? kMaxAngleBits : nbits);
+}
+
+double JetTreeQuantization::GetMaxPtRelError() const {
+	return std::ldexp(1., -fPtMantissaBits);
+}
+
+double JetTreeQuantization::GetMaxAngleError() const {
+	return std::ldexp(1., -(fAngleFractionBits + 1));
+}
+
+JetTreeCompactConstituent::JetTreeCompactConstituent():
+		TObject(),
+		fPt(0),
+		fEta(0),
+		fPhi(0),
+		fPDG(0)
+{
+}
+
+JetTreeCompactConstituent::JetTreeCompactConstituent(double pt, double eta, double phi, int pdg):
+		TObject(),
+		fPt(pt),
+		fEta(eta),
+		fPhi(phi),
+		fPDG(pdg)
+{
+}
+
+/**
+ * Reconstruct the four-vector, using the nominal mass of the particle species
+ */
+void JetTreeCompactConstituent::GetPxPyPzE(double *pxyz) const {
+	double mass = GetMass();
+	pxyz[0] = fPt * std::cos(fPhi);
+	pxyz[1] = fPt * std::sin(fPhi);
+	pxyz[2] = fPt * std::sinh(fEta);
+	pxyz[3] = std::sqrt(pxyz[0]*pxyz[0] + pxyz[1]*pxyz[1] + pxyz[2]*pxyz[2] + mass*mass);
+}
+
+/**
+ * Nominal mass for a PDG code. Common final state particles are
+ * handled directly, others are looked up in the ROOT PDG database.
+ */
+double JetTreeCompactConstituent::GetMassForPdg(int pdg){
+	switch(std::abs(pdg)){
+	case 22: case 12: case 14: case 16: return 0.;
+	case 11: return 0.000510999;
+	case 13: return 0.105658;
+	case 211: return 0.139570;
+	case 321: return 0.493677;
+	case 130: return 0.497611;
+	case 2212: return 0.938272;
+	case 2112: return 0.939565;
+	default: break;
+	};
+	TParticlePDG *part = TDatabasePDG::Instance()->GetParticle(pdg);
+	return part ? part->Mass() : 0.;
+}
+
+JetTreeCompactData::JetTreeCompactData():
+		fPx(0),
+		fPy(0),
+		fPz(0),
+		fE(0),
+		fConstituents()
+{
+}
+
+JetTreeCompactData::JetTreeCompactData(double px, double py, double pz, double e):
+		fPx(px),
+		fPy(py),
+		fPz(pz),
+		fE(e),
+		fConstituents()
+{
+}
+
+void JetTreeCompactData::AddConstituent(double px, double py, double pz, double e, int pdg, const JetTreeQuantization &quant){
+	fConstituents.push_back(JetTreeCompactConstituent());
+	fConstituents.back().SetFromPxPyPzE(px, py, pz, e, pdg, quant);
+}
+
+void JetTreeCompactData::Reset(){
+	fPx = 0;
+	fPy = 0;
+	fPz = 0;
+	fE = 0;
+	fConstituents.clear();
+}
+
+/**
+ * Release oversized constituent buffer, discarding the constituents
+ * (see JetTreeData::ShrinkConstituents)
+ */
+void JetTreeCompactData::ShrinkConstituents(size_t maxcapacity){
+	if(fConstituents.capacity() <= maxcapacity) return;
+	std::vector<JetTreeCompactConstituent>().swap(fConstituents);
+	fConstituents.reserve(maxcapacity);
+}
+
+/**
+ * Expand into the legacy format with reconstructed constituent four-vectors
+ */
+void JetTreeCompactData::ToJetTreeData(JetTreeData &result) const {
+	result.Set(fPx, fPy, fPz, fE);
+	result.ResizeConstituents(fConstituents.size());
+	double pxyz[4];
+	for(size_t iconst = 0; iconst < fConstituents.size(); iconst++){
+		fConstituents[iconst].GetPxPyPzE(pxyz);
+		result.GetConstituent(iconst).Set(pxyz[0], pxyz[1], pxyz[2], pxyz[3], fConstituents[iconst].GetPdg());
+	}
+}
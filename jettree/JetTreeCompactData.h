@@ -0,0 +1,154 @@
+#ifndef JETTREE_JETTREECOMPACTDATA_H_
+#define JETTREE_JETTREECOMPACTDATA_H_
+/*
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version. (See cxx source for full Copyright notice)
+ */
+
+#include <TObject.h>
+#include <TMath.h>
+#include <cmath>
+#include <vector>
+
+class JetTreeData;
+
+/**
+ * Quantization applied to constituents before storing them in compact
+ * format. Max. errors with respect to the generated values:
+ *
+ *   - pt:      relative error <= 2^-ptbits          (default 10 bits: 9.8e-4)
+ *   - eta/phi: absolute error <= 2^-(anglebits + 1) (default 10 bits: 4.9e-4)
+ *
+ * pt is limited to 14 mantissa bits, eta/phi to 10 fraction bits (for
+ * |eta| < 32), which the 14 bit mantissa storage of
+ * JetTreeCompactConstituent represents without further loss. eta is
+ * clamped to |eta| <= 32 - 2^-anglebits, which also applies to particles
+ * along the beam axis (pt = 0).
+ *
+ * Jet four-vectors are not quantized but stored as Double32_t, i.e. in
+ * float precision: relative error <= 2^-24 (6.0e-8) on px, py, pz and E.
+ */
+class JetTreeQuantization {
+public:
+	JetTreeQuantization(int ptbits = 10, int anglebits = 10);
+	~JetTreeQuantization() {}
+
+	void SetPtMantissaBits(int nbits);
+	void SetAngleFractionBits(int nbits);
+
+	int GetPtMantissaBits() const { return fPtMantissaBits; }
+	int GetAngleFractionBits() const { return fAngleFractionBits; }
+	double GetMaxPtRelError() const;
+	double GetMaxAngleError() const;
+
+	inline double QuantizePt(double pt) const;
+	inline double QuantizeAngle(double angle) const;
+	inline double ClampEta(double eta) const;
+
+	static const int kMaxPtBits = 14;
+	static const int kMaxAngleBits = 10;
+	static const int kMaxAbsEta = 32;
+
+private:
+	int									fPtMantissaBits;
+	int									fAngleFractionBits;
+};
+
+/**
+ * Constituent stored as (pt, eta, phi, PDG). Kinematics are stored with
+ * 14 bit mantissa, the mass is reconstructed from the PDG code.
+ */
+class JetTreeCompactConstituent : public TObject {
+public:
+	JetTreeCompactConstituent();
+	JetTreeCompactConstituent(double pt, double eta, double phi, int pdg);
+	virtual ~JetTreeCompactConstituent() {}
+
+	void Set(double pt, double eta, double phi, int pdg) { fPt = pt; fEta = eta; fPhi = phi; fPDG = pdg; }
+	inline void SetFromPxPyPzE(double px, double py, double pz, double e, int pdg, const JetTreeQuantization &quant);
+
+	double GetPt() const { return fPt; }
+	double GetEta() const { return fEta; }
+	double GetPhi() const { return fPhi; }
+	int GetPdg() const { return fPDG; }
+	double GetMass() const { return GetMassForPdg(fPDG); }
+	void GetPxPyPzE(double *pxyz) const;
+
+	static double GetMassForPdg(int pdg);
+
+protected:
+	Float16_t			fPt;		//[0,0,14]
+	Float16_t			fEta;		//[0,0,14]
+	Float16_t			fPhi;		//[0,0,14]
+	Int_t				fPDG;
+
+	ClassDef(JetTreeCompactConstituent, 1);
+};
+
+class JetTreeCompactData {
+public:
+	JetTreeCompactData();
+	JetTreeCompactData(double px, double py, double pz, double e);
+	virtual ~JetTreeCompactData() {}
+
+	void AddConstituent(double px, double py, double pz, double e, int pdg, const JetTreeQuantization &quant);
+	void Set(double px, double py, double pz, double e) { fPx = px; fPy = py; fPz = pz; fE = e; }
+
+	double GetPx() const { return fPx; }
+	double GetPy() const { return fPy; }
+	double GetPz() const { return fPz; }
+	double GetE() const { return fE; }
+	const std::vector<JetTreeCompactConstituent> &GetConstituent() const { return fConstituents; }
+	JetTreeCompactConstituent &GetConstituent(size_t index) { return fConstituents[index]; }
+	size_t GetConstituentCapacity() const { return fConstituents.capacity(); }
+	void ResizeConstituents(size_t nconstituents) { fConstituents.resize(nconstituents); }
+
+	void Reset();
+	void ShrinkConstituents(size_t maxcapacity);
+	void ToJetTreeData(JetTreeData &result) const;
+
+private:
+	Double32_t									fPx;
+	Double32_t									fPy;
+	Double32_t									fPz;
+	Double32_t									fE;
+	std::vector<JetTreeCompactConstituent>		fConstituents;
+
+	ClassDef(JetTreeCompactData, 1);
+};
+
+/**
+ * Round pt to the configured number of mantissa bits
+ */
+double JetTreeQuantization::QuantizePt(double pt) const {
+	int exponent;
+	double mantissa = std::frexp(pt, &exponent);
+	return std::ldexp(std::round(std::ldexp(mantissa, fPtMantissaBits)), exponent - fPtMantissaBits);
+}
+
+/**
+ * Round eta or phi to a fixed-point grid with step 2^-anglebits
+ */
+double JetTreeQuantization::QuantizeAngle(double angle) const {
+	return std::ldexp(std::round(std::ldexp(angle, fAngleFractionBits)), -fAngleFractionBits);
+}
+
+/**
+ * Limit eta to the largest grid point representable in the storage
+ */
+double JetTreeQuantization::ClampEta(double eta) const {
+	double etamax = kMaxAbsEta - std::ldexp(1., -fAngleFractionBits);
+	return eta > etamax ? etamax : (eta < -etamax ? -etamax : eta);
+}
+
+void JetTreeCompactConstituent::SetFromPxPyPzE(double px, double py, double pz, double, int pdg, const JetTreeQuantization &quant){
+	double pt = std::sqrt(px*px + py*py);
+	double phi = std::atan2(py, px);
+	if(phi < 0) phi += TMath::TwoPi();
+	double eta = quant.ClampEta(pt > 0 ? std::asinh(pz/pt) : (pz >= 0 ? JetTreeQuantization::kMaxAbsEta : -JetTreeQuantization::kMaxAbsEta));
+	Set(quant.QuantizePt(pt), quant.QuantizeAngle(eta), quant.QuantizeAngle(phi), pdg);
+}
+
+#endif
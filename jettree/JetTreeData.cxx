@@ -49,6 +49,20 @@ void JetTreeData::Reset(){
 	fConstituents.clear();
 }
 
+/**
+ * Release constituent memory if the buffer grew beyond the given capacity
+ * and keep a buffer of exactly that capacity. The constituents are
+ * discarded, so this is only meant to be called before the record is
+ * refilled.
+ *
+ * @param maxcapacity Max. number of constituents kept allocated
+ */
+void JetTreeData::ShrinkConstituents(size_t maxcapacity){
+	if(fConstituents.capacity() <= maxcapacity) return;
+	std::vector<JetTreeConstituent>().swap(fConstituents);
+	fConstituents.reserve(maxcapacity);
+}
+
 JetTreeConstituent::JetTreeConstituent():
 		TObject(),
 		fPx(0),
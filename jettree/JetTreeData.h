@@ -50,8 +50,12 @@ public:
 	inline void GetPxPyPzE(double *pxyz);
 	double GetE() const { return fE; }
 	const std::vector<JetTreeConstituent> &GetConstituent() const { return fConstituents; }
+	JetTreeConstituent &GetConstituent(size_t index) { return fConstituents[index]; }
+	size_t GetConstituentCapacity() const { return fConstituents.capacity(); }
+	void ResizeConstituents(size_t nconstituents) { fConstituents.resize(nconstituents); }
 
 	void Reset();
+	void ShrinkConstituents(size_t maxcapacity);
 
 private:
 	double								fPx;
@@ -0,0 +1,135 @@
+/****************************************************************************
+ * Analysis of electrons in jets 							                *
+ * Copyright (C) 2015  Markus Fasel, Lawrence Berkeley National Laboratory  *
+ *                                                                          *
+ * This program is free software: you can redistribute it and/or modify     *
+ * it under the terms of the GNU General Public License as published by     *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful,          *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ * GNU General Public License for more details.                             *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License        *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ ****************************************************************************/
+#include "jettree/JetTreeFlatData.h"
+#include "jettree/JetTreeData.h"
+
+#include <TTree.h>
+
+#include <stdexcept>
+
+namespace {
+	template<typename T>
+	void ShrinkColumn(std::vector<T> &column, size_t maxcapacity){
+		if(column.capacity() <= maxcapacity) return;
+		std::vector<T>().swap(column);
+		column.reserve(maxcapacity);
+	}
+}
+
+JetTreeFlatData::JetTreeFlatData():
+		fJetPx(),
+		fJetPy(),
+		fJetPz(),
+		fJetE(),
+		fJetNConstituents(),
+		fConstituentPx(),
+		fConstituentPy(),
+		fConstituentPz(),
+		fConstituentE(),
+		fConstituentPDG(),
+		fBranchAddresses()
+{
+}
+
+void JetTreeFlatData::CreateBranches(TTree *tree){
+	tree->Branch("jet_px", &fJetPx);
+	tree->Branch("jet_py", &fJetPy);
+	tree->Branch("jet_pz", &fJetPz);
+	tree->Branch("jet_e", &fJetE);
+	tree->Branch("jet_nconst", &fJetNConstituents);
+	tree->Branch("const_px", &fConstituentPx);
+	tree->Branch("const_py", &fConstituentPy);
+	tree->Branch("const_pz", &fConstituentPz);
+	tree->Branch("const_e", &fConstituentE);
+	tree->Branch("const_pdg", &fConstituentPDG);
+}
+
+void JetTreeFlatData::SetBranchAddresses(TTree *tree){
+	const char *names[] = {"jet_px", "jet_py", "jet_pz", "jet_e", "jet_nconst",
+			"const_px", "const_py", "const_pz", "const_e", "const_pdg"};
+	fBranchAddresses = {&fJetPx, &fJetPy, &fJetPz, &fJetE, &fJetNConstituents,
+			&fConstituentPx, &fConstituentPy, &fConstituentPz, &fConstituentE, &fConstituentPDG};
+	// object branches expect the address of a pointer to the column
+	for(size_t ibranch = 0; ibranch < fBranchAddresses.size(); ibranch++)
+		tree->SetBranchAddress(names[ibranch], static_cast<void *>(&fBranchAddresses[ibranch]));
+}
+
+/**
+ * Resize all columns, keeping their allocated memory
+ *
+ * @param njets Number of jets
+ * @param nconstituents Total number of constituents of all jets
+ */
+void JetTreeFlatData::Resize(size_t njets, size_t nconstituents){
+	fJetPx.resize(njets);
+	fJetPy.resize(njets);
+	fJetPz.resize(njets);
+	fJetE.resize(njets);
+	fJetNConstituents.resize(njets);
+	fConstituentPx.resize(nconstituents);
+	fConstituentPy.resize(nconstituents);
+	fConstituentPz.resize(nconstituents);
+	fConstituentE.resize(nconstituents);
+	fConstituentPDG.resize(nconstituents);
+}
+
+/**
+ * Release columns grown beyond the given capacities. Contents of released
+ * columns are discarded, so this is only meant to be called before refilling.
+ *
+ * @param maxjets Max. number of jets kept allocated
+ * @param maxconstituents Max. number of constituents kept allocated
+ */
+void JetTreeFlatData::ShrinkColumns(size_t maxjets, size_t maxconstituents){
+	ShrinkColumn(fJetPx, maxjets);
+	ShrinkColumn(fJetPy, maxjets);
+	ShrinkColumn(fJetPz, maxjets);
+	ShrinkColumn(fJetE, maxjets);
+	ShrinkColumn(fJetNConstituents, maxjets);
+	ShrinkColumn(fConstituentPx, maxconstituents);
+	ShrinkColumn(fConstituentPy, maxconstituents);
+	ShrinkColumn(fConstituentPz, maxconstituents);
+	ShrinkColumn(fConstituentE, maxconstituents);
+	ShrinkColumn(fConstituentPDG, maxconstituents);
+}
+
+void JetTreeFlatData::ToJetTreeData(std::vector<JetTreeData> &result) const {
+	size_t nconstituents = 0;
+	for(auto nconst : fJetNConstituents){
+		if(nconst < 0) throw std::runtime_error("Negative number of jet constituents in flat jet tree");
+		nconstituents += nconst;
+	}
+	size_t njets = fJetPx.size();
+	if(fJetPy.size() != njets || fJetPz.size() != njets || fJetE.size() != njets
+			|| fJetNConstituents.size() != njets || nconstituents != fConstituentPx.size()
+			|| fConstituentPy.size() != nconstituents || fConstituentPz.size() != nconstituents
+			|| fConstituentE.size() != nconstituents || fConstituentPDG.size() != nconstituents)
+		throw std::runtime_error("Inconsistent column sizes in flat jet tree");
+
+	result.resize(fJetPx.size());
+	size_t iconst = 0;
+	for(size_t ijet = 0; ijet < fJetPx.size(); ijet++){
+		JetTreeData &jet = result[ijet];
+		jet.Set(fJetPx[ijet], fJetPy[ijet], fJetPz[ijet], fJetE[ijet]);
+		jet.ResizeConstituents(fJetNConstituents[ijet]);
+		for(int ic = 0; ic < fJetNConstituents[ijet]; ic++, iconst++){
+			jet.GetConstituent(ic).Set(fConstituentPx[iconst], fConstituentPy[iconst], fConstituentPz[iconst],
+					fConstituentE[iconst], fConstituentPDG[iconst]);
+		}
+	}
+}
@@ -0,0 +1,60 @@
+#ifndef JETTREE_JETTREEFLATDATA_H_
+#define JETTREE_JETTREEFLATDATA_H_
+/*
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version. (See cxx source for full Copyright notice)
+ */
+
+#include <cstddef>
+#include <vector>
+
+class JetTreeData;
+class TTree;
+
+/**
+ * Jets of one event stored as flat columns, one branch per quantity.
+ * Constituents of all jets are stored consecutively; jet i owns
+ * GetNumberOfConstituents(i) entries following those of jet i-1.
+ */
+class JetTreeFlatData {
+public:
+	JetTreeFlatData();
+	~JetTreeFlatData() {}
+
+	void CreateBranches(TTree *tree);
+	void SetBranchAddresses(TTree *tree);
+
+	void Resize(size_t njets, size_t nconstituents);
+	void ShrinkColumns(size_t maxjets, size_t maxconstituents);
+	void Reset() { Resize(0, 0); }
+
+	void SetJet(size_t ijet, double px, double py, double pz, double e, int nconstituents) {
+		fJetPx[ijet] = px; fJetPy[ijet] = py; fJetPz[ijet] = pz; fJetE[ijet] = e;
+		fJetNConstituents[ijet] = nconstituents;
+	}
+	void SetConstituent(size_t iconst, double px, double py, double pz, double e, int pdg) {
+		fConstituentPx[iconst] = px; fConstituentPy[iconst] = py; fConstituentPz[iconst] = pz; fConstituentE[iconst] = e;
+		fConstituentPDG[iconst] = pdg;
+	}
+
+	size_t GetNumberOfJets() const { return fJetPx.size(); }
+	int GetNumberOfConstituents(size_t ijet) const { return fJetNConstituents[ijet]; }
+	void ToJetTreeData(std::vector<JetTreeData> &result) const;
+
+private:
+	std::vector<double>					fJetPx;
+	std::vector<double>					fJetPy;
+	std::vector<double>					fJetPz;
+	std::vector<double>					fJetE;
+	std::vector<int>					fJetNConstituents;
+	std::vector<double>					fConstituentPx;
+	std::vector<double>					fConstituentPy;
+	std::vector<double>					fConstituentPz;
+	std::vector<double>					fConstituentE;
+	std::vector<int>					fConstituentPDG;
+	std::vector<void *>					fBranchAddresses;			/// Column addresses handed to the tree when reading
+};
+
+#endif
@@ -11,5 +11,7 @@
 
 #pragma link C++ class JetTreeConstituent+;
 #pragma link C++ class JetTreeData;
+#pragma link C++ class JetTreeCompactConstituent+;
+#pragma link C++ class JetTreeCompactData;
 
 #endif
@@ -0,0 +1,107 @@
+/****************************************************************************
+ * Analysis of electrons in jets 							                *
+ * Copyright (C) 2015  Markus Fasel, Lawrence Berkeley National Laboratory  *
+ *                                                                          *
+ * This program is free software: you can redistribute it and/or modify     *
+ * it under the terms of the GNU General Public License as published by     *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful,          *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ * GNU General Public License for more details.                             *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License        *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ ****************************************************************************/
+#include "jettree/JetTreeReader.h"
+
+#include <TBranch.h>
+#include <TFile.h>
+#include <TParameter.h>
+#include <TTree.h>
+
+#include <stdexcept>
+
+JetTreeReader::JetTreeReader(const std::string &filename):
+		fInputFile(TFile::Open(filename.c_str())),
+		fInputTree(nullptr),
+		fIsCompact(false),
+		fIsFlat(false),
+		fHasQuantization(false),
+		fQuantization(),
+		fCurrentEntry(-1),
+		fLegacyJets(nullptr),
+		fCompactJets(nullptr),
+		fFlatJets(),
+		fExpandedJets()
+{
+	if(!fInputFile || fInputFile->IsZombie())
+		throw std::runtime_error("Cannot open jet tree file " + filename);
+	fInputFile->GetObject("JetTree", fInputTree);
+	if(!fInputTree)
+		throw std::runtime_error("No jet tree found in " + filename);
+	if(fInputTree->GetBranch("jet_px")){
+		fIsFlat = true;
+		fFlatJets.SetBranchAddresses(fInputTree);
+		return;
+	}
+	TBranch *jetbranch = fInputTree->GetBranch("jets");
+	if(!jetbranch)
+		throw std::runtime_error("No jet branch found in " + filename);
+	std::string classname = jetbranch->GetClassName();
+	fIsCompact = classname.find("JetTreeCompactData") != std::string::npos;
+	// allocate the containers ourselves, so GetJets is valid before the first event is read
+	if(fIsCompact){
+		fCompactJets = new std::vector<JetTreeCompactData>;
+		fInputTree->SetBranchAddress("jets", &fCompactJets);
+		TParameter<int> *ptbits = nullptr, *anglebits = nullptr;
+		fInputFile->GetObject("ptMantissaBits", ptbits);
+		fInputFile->GetObject("angleFractionBits", anglebits);
+		if(ptbits && anglebits){
+			fQuantization = JetTreeQuantization(ptbits->GetVal(), anglebits->GetVal());
+			fHasQuantization = true;
+		}
+		delete ptbits;
+		delete anglebits;
+	} else {
+		fLegacyJets = new std::vector<JetTreeData>;
+		fInputTree->SetBranchAddress("jets", &fLegacyJets);
+	}
+}
+
+JetTreeReader::~JetTreeReader(){
+	if(fInputTree) fInputTree->ResetBranchAddresses();
+	delete fLegacyJets;
+	delete fCompactJets;
+}
+
+long JetTreeReader::GetNumberOfEvents() const {
+	return fInputTree->GetEntries();
+}
+
+bool JetTreeReader::NextEvent(){
+	return ReadEvent(fCurrentEntry + 1);
+}
+
+/**
+ * Read event and, for compact and flat trees, expand jets into the legacy format
+ *
+ * @param entry Entry number in the tree
+ * @return False if the entry is out of range
+ */
+bool JetTreeReader::ReadEvent(long entry){
+	if(entry < 0 || entry >= GetNumberOfEvents()) return false;
+	fCurrentEntry = entry;
+	if(fInputTree->GetEntry(entry) <= 0)
+		throw std::runtime_error("Cannot read entry " + std::to_string(entry) + " of the jet tree");
+	if(fIsCompact){
+		fExpandedJets.resize(fCompactJets->size());
+		for(size_t ijet = 0; ijet < fCompactJets->size(); ijet++)
+			(*fCompactJets)[ijet].ToJetTreeData(fExpandedJets[ijet]);
+	} else if(fIsFlat){
+		fFlatJets.ToJetTreeData(fExpandedJets);
+	}
+	return true;
+}
@@ -0,0 +1,57 @@
+#ifndef JETTREE_JETTREEREADER_H_
+#define JETTREE_JETTREEREADER_H_
+/*
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version. (See cxx source for full Copyright notice)
+ */
+
+#include "jettree/JetTreeCompactData.h"
+#include "jettree/JetTreeData.h"
+#include "jettree/JetTreeFlatData.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class TFile;
+class TTree;
+
+/**
+ * Reader for jet trees in legacy, compact or flat column format. Jets
+ * are always provided in legacy format, other formats are expanded
+ * into four-vectors on the fly.
+ */
+class JetTreeReader {
+public:
+	JetTreeReader(const std::string &filename);
+	virtual ~JetTreeReader();
+
+	bool IsCompact() const { return fIsCompact; }
+	bool IsFlat() const { return fIsFlat; }
+	const JetTreeQuantization *GetQuantization() const { return fHasQuantization ? &fQuantization : nullptr; }
+	long GetNumberOfEvents() const;
+	bool NextEvent();
+	bool ReadEvent(long entry);
+
+	const std::vector<JetTreeData> &GetJets() const { return (fIsCompact || fIsFlat) ? fExpandedJets : *fLegacyJets; }
+
+private:
+	JetTreeReader(const JetTreeReader &);
+	JetTreeReader &operator=(const JetTreeReader &);
+
+	std::unique_ptr<TFile>						fInputFile;
+	TTree										*fInputTree;
+	bool										fIsCompact;
+	bool										fIsFlat;
+	bool										fHasQuantization;
+	JetTreeQuantization							fQuantization;
+	long										fCurrentEntry;
+	std::vector<JetTreeData>					*fLegacyJets;
+	std::vector<JetTreeCompactData>				*fCompactJets;
+	JetTreeFlatData								fFlatJets;
+	std::vector<JetTreeData>					fExpandedJets;
+};
+
+#endif
@@ -57,7 +57,29 @@ void ElectronJetFinder::FindJets(const Pythia8::Event &input){
 		inputjet.set_user_info(new ElectronJetFinder::ParticleStruct(&mypart));
 		inputparticles.push_back(inputjet);
 	}
+	ClusterJets(inputparticles);
+}
+
+/**
+ * Find jets in a snapshot of the final state particles of an event. Accepted
+ * jets keep copies of their constituents, so the snapshot is only needed
+ * during the call.
+ *
+ * @param finalstate Final state particles
+ */
+void ElectronJetFinder::FindJets(const std::vector<Pythia8::Particle> &finalstate){
+	fJets.clear();
+	std::vector<fastjet::PseudoJet> inputparticles;
+	inputparticles.reserve(finalstate.size());
+	for(const auto &mypart : finalstate){
+		fastjet::PseudoJet inputjet(mypart.px(), mypart.py(), mypart.pz(), mypart.e());
+		inputjet.set_user_info(new ElectronJetFinder::ParticleStruct(&mypart));
+		inputparticles.push_back(inputjet);
+	}
+	ClusterJets(inputparticles);
+}
 
+void ElectronJetFinder::ClusterJets(const std::vector<fastjet::PseudoJet> &inputparticles){
 	fastjet::ClusterSequence jetfinder(inputparticles, fJetDefinition);
 	std::vector<fastjet::PseudoJet> recjets = sorted_by_pt(jetfinder.jets());
 
@@ -28,7 +28,7 @@ public:
 	void AddConstituent(const Pythia8::Particle &part) { fParticles.push_back(part); }
 
 	const fastjet::PseudoJet &GetPseudoJet() const { return fJetVector; }
-	const std::vector<Pythia8::Particle> GetParticles() const { return fParticles; }
+	const std::vector<Pythia8::Particle> &GetParticles() const { return fParticles; }
 
 	std::vector<const Pythia8::Particle> FindElectrons() const;
 
@@ -81,12 +81,16 @@ public:
 	void SetElectronPtCut(double minpt) { fElectronPtCut = minpt; }
 
 	void SetJetDefinition(const fastjet::JetDefinition &jetdef) { fJetDefinition = jetdef; }
+	const fastjet::JetDefinition &GetJetDefinition() const { return fJetDefinition; }
 
 	void FindJets(const Pythia8::Event & inputEvent);
+	void FindJets(const std::vector<Pythia8::Particle> &finalstate);
 
 	const std::vector<ElectronJet> &GetJets() const { return fJets; }
+	void TakeJets(std::vector<ElectronJet> &jets) { jets.swap(fJets); fJets.clear(); }
 
 protected:
+	void ClusterJets(const std::vector<fastjet::PseudoJet> &inputparticles);
 	std::vector<const fastjet::PseudoJet> FindElectron(const fastjet::PseudoJet &inputjet) const;
 	const fastjet::PseudoJet *FindLeading(const fastjet::PseudoJet &inputjet) const;
 
@@ -16,89 +16,292 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
  ****************************************************************************/
 #include "ElectronJetTreeCreator.h"
+#include "JetTreeConverter.h"
+#include "PrefetchingEventSource.h"
 
+#include <TFile.h>
+#include <TParameter.h>
 #include <TTree.h>
 
 #include <Pythia8/Event.h>
 #include <fastjet/JetDefinition.hh>
 #include <fastjet/PseudoJet.hh>
 
+#include <stdexcept>
 #include <vector>
 
+namespace {
+	/**
+	 * Release records and constituent buffers grown beyond their caps. The
+	 * records are discarded, so this must only run before they are refilled.
+	 */
+	template<typename Record_t>
+	void ReleaseOversizedRecords(std::vector<Record_t> &records, size_t maxrecords, size_t maxconstituents){
+		if(records.capacity() > maxrecords){
+			std::vector<Record_t>().swap(records);
+			records.reserve(maxrecords);
+			return;
+		}
+		for(auto &record : records) record.ShrinkConstituents(maxconstituents);
+	}
+}
+
 ElectronJetTreeCreator::ElectronJetTreeCreator() :
 	fJetFinder(),
-	fGenerator(),
+	fEventSource(std::unique_ptr<EventSource>(new Generator)),
+	fPrefetchDepth(0),
+	fInitialized(false),
+	fNClusterThreads(0),
+	fJetFinderPool(),
+	fClusteredJets(),
+	fPendingWeights(),
 	fOutputFileName("JetTree.root"),
 	fOutputFile(),
 	fOutputTree(),
-	fElectronJets(std::unique_ptr<std::vector<JetTreeData> >(new std::vector<JetTreeData>))
+	fOutputFormat(kLegacyFormat),
+	fQuantization(),
+	fEventWeight(1.),
+	fCrossSection(0.),
+	fElectronJets(std::unique_ptr<std::vector<JetTreeData> >(new std::vector<JetTreeData>)),
+	fCompactElectronJets(std::unique_ptr<std::vector<JetTreeCompactData> >(new std::vector<JetTreeCompactData>)),
+	fFlatElectronJets(std::unique_ptr<JetTreeFlatData>(new JetTreeFlatData)),
+	fMemoryBudget(0),
+	fBasketMemoryLimit(0),
+	fMaxJetCapacity(64),
+	fMaxConstituentCapacity(256),
+	fMemorySamplingInterval(100),
+	fOverMemoryBudget(false),
+	fBasketsLimited(false),
+	fMemoryMonitor()
 {
 }
 
 ElectronJetTreeCreator::ElectronJetTreeCreator(Generator::Parton_t parton):
 	fJetFinder(),
-	fGenerator(parton),
+	fEventSource(std::unique_ptr<EventSource>(new Generator(parton))),
+	fPrefetchDepth(0),
+	fInitialized(false),
+	fNClusterThreads(0),
+	fJetFinderPool(),
+	fClusteredJets(),
+	fPendingWeights(),
 	fOutputFileName("JetTree.root"),
 	fOutputFile(),
 	fOutputTree(),
-	fElectronJets(std::unique_ptr<std::vector<JetTreeData> >(new std::vector<JetTreeData>))
+	fOutputFormat(kLegacyFormat),
+	fQuantization(),
+	fEventWeight(1.),
+	fCrossSection(0.),
+	fElectronJets(std::unique_ptr<std::vector<JetTreeData> >(new std::vector<JetTreeData>)),
+	fCompactElectronJets(std::unique_ptr<std::vector<JetTreeCompactData> >(new std::vector<JetTreeCompactData>)),
+	fFlatElectronJets(std::unique_ptr<JetTreeFlatData>(new JetTreeFlatData)),
+	fMemoryBudget(0),
+	fBasketMemoryLimit(0),
+	fMaxJetCapacity(64),
+	fMaxConstituentCapacity(256),
+	fMemorySamplingInterval(100),
+	fOverMemoryBudget(false),
+	fBasketsLimited(false),
+	fMemoryMonitor()
 {
 }
 
 void ElectronJetTreeCreator::Init() {
+	if(fPrefetchDepth > 0){
+		fEventSource = std::unique_ptr<EventSource>(new PrefetchingEventSource(fEventSource.release(), fPrefetchDepth));
+	}
+	fEventSource->Init();
+	if(fNClusterThreads > 0){
+		fJetFinderPool = std::unique_ptr<JetFinderPool>(new JetFinderPool(fJetFinder, fNClusterThreads));
+	}
+
 	fOutputFile = std::unique_ptr<TFile>(new TFile(fOutputFileName.c_str(), "RECREATE"));
 	fOutputTree = std::unique_ptr<TTree>(new TTree("JetTree", "Electron jet tree"));
-	fOutputTree->Branch("jets", &(fElectronJets.get()));
+	switch(fOutputFormat){
+	case kCompactFormat: fOutputTree->Branch("jets", fCompactElectronJets.get()); break;
+	case kFlatFormat: fFlatElectronJets->CreateBranches(fOutputTree.get()); break;
+	default: fOutputTree->Branch("jets", fElectronJets.get()); break;
+	};
+	fOutputTree->Branch("weight", &fEventWeight, "weight/D");
+	if(fBasketMemoryLimit){
+		// negative value: the first cluster is written once the given number of
+		// compressed bytes is reached, ROOT then converts this into an entry count
+		fOutputTree->SetAutoFlush(-static_cast<Long64_t>(fBasketMemoryLimit));
+	}
+	fInitialized = true;
 }
 
 void ElectronJetTreeCreator::Process(int nevents) {
-	for(int iev = 0; iev < nevents; iev++){
-		Generate();
-		fOutputTree->Write();
+	if(fJetFinderPool){
+		ProcessParallel(nevents);
+	} else {
+		for(int iev = 0; iev < nevents; iev++){
+			if(!Generate()) break;
+			fOutputTree->Fill();
+			EnforceMemoryLimits(iev);
+		}
+	}
+	fOutputFile->cd();
+	fOutputTree->Write();
+	// cross section estimate of the last event is the most precise one
+	TParameter<double> crosssection("sigmaGen", fCrossSection);
+	crosssection.Write();
+	if(fOutputFormat == kCompactFormat){
+		// quantization settings define the error bounds of the stored constituents
+		TParameter<int> ptbits("ptMantissaBits", fQuantization.GetPtMantissaBits());
+		TParameter<int> anglebits("angleFractionBits", fQuantization.GetAngleFractionBits());
+		ptbits.Write();
+		anglebits.Write();
 	}
+	// final sample, the summary is available via GetMemoryMonitor
+	if(fMemorySamplingInterval > 0) fMemoryMonitor.Sample();
+}
+
+/**
+ * Output buffers which grew beyond their configured capacity due to a
+ * large event are released before the next event is converted, so
+ * their contents are never copied. The constituent cap applies per jet;
+ * the constituent columns of the flat format hold all jets of the event
+ * and are capped at jet cap times constituent cap.
+ */
+void ElectronJetTreeCreator::ReleaseOversizedBuffers(){
+	switch(fOutputFormat){
+	case kCompactFormat: ReleaseOversizedRecords(*fCompactElectronJets, fMaxJetCapacity, fMaxConstituentCapacity); break;
+	case kFlatFormat: fFlatElectronJets->ShrinkColumns(fMaxJetCapacity, fMaxJetCapacity * fMaxConstituentCapacity); break;
+	default: ReleaseOversizedRecords(*fElectronJets, fMaxJetCapacity, fMaxConstituentCapacity); break;
+	};
 }
 
-void ElectronJetTreeCreator::Generate() {
-	fElectronJets->clear();
+/**
+ * Keep the memory footprint bounded. ROOT sizes the baskets at the first
+ * flush; right after it they are resized to fit the basket memory limit,
+ * which then holds for the rest of the run. When the process exceeds its
+ * memory budget the baskets are flushed to file and resized again. As freed memory is usually not returned to the
+ * system, this happens once when the budget is exceeded and is only
+ * re-armed after the RSS dropped below the budget again.
+ *
+ * The budget is checked at the memory sampling interval, or every
+ * kDefaultBudgetCheckInterval events if sampling is switched off.
+ *
+ * @param iev Number of the current event
+ */
+void ElectronJetTreeCreator::EnforceMemoryLimits(int iev){
+	if(fBasketMemoryLimit && !fBasketsLimited && fOutputTree->GetZipBytes() > 0){
+		fOutputTree->OptimizeBaskets(fBasketMemoryLimit, 1.1, "");
+		fBasketsLimited = true;
+	}
 
-	fGenerator.Generate();
-	fJetFinder.FindJets(fGenerator.GetEvent());
-	for(auto injet : fJetFinder.GetJets()){
-		fElectronJets->push_back(ConvertElectronJet(injet));
+	int interval = fMemorySamplingInterval;
+	if(interval <= 0){
+		if(!fMemoryBudget) return;
+		interval = kDefaultBudgetCheckInterval;
+	}
+	if(iev % interval) return;
+	fMemoryMonitor.Sample();
+	if(!fMemoryBudget) return;
+	bool overbudget = fMemoryMonitor.GetCurrentRSS() > fMemoryBudget;
+	if(overbudget && !fOverMemoryBudget){
+		fOutputTree->FlushBaskets();
+		if(fBasketMemoryLimit) fOutputTree->OptimizeBaskets(fBasketMemoryLimit, 1.1, "");
 	}
+	fOverMemoryBudget = overbudget;
 }
 
-JetTreeData ElectronJetTreeCreator::ConvertElectronJet(const ElectronJet &inputjet) const {
-	fastjet::PseudoJet jetvec = inputjet.GetPseudoJet();
-	JetTreeData result(jetvec.px(), jetvec.py(), jetvec.pz(), jetvec.E());
-	for(auto myconst : inputjet.GetParticles()){
-		result.AddConstituent(myconst.px(), myconst.py(), myconst.pz(), myconst.e(), myconst.id());
+/**
+ * Generation and clustering overlapping in time: the event source runs in
+ * this thread and keeps the jet finder pool filled with snapshots of the
+ * final state, while the clustered events are written in generation order.
+ *
+ * @param nevents Number of events to generate
+ */
+void ElectronJetTreeCreator::ProcessParallel(int nevents) {
+	int nsubmitted = 0, nwritten = 0;
+	bool sourcedone = false;
+	while(true){
+		while(!sourcedone && nsubmitted < nevents && fJetFinderPool->CanSubmit()){
+			if(!fEventSource->NextEvent()){
+				sourcedone = true;
+				break;
+			}
+			fJetFinderPool->Submit(JetFinderPool::MakeSnapshot(fEventSource->GetEvent()));
+			fPendingWeights.push_back(fEventSource->GetWeight());
+			fCrossSection = fEventSource->GetCrossSection();
+			nsubmitted++;
+		}
+		if(!fJetFinderPool->NextResult(fClusteredJets)) break;
+		fEventWeight = fPendingWeights.front();
+		fPendingWeights.pop_front();
+		FillJets(fClusteredJets);
+		fOutputTree->Fill();
+		EnforceMemoryLimits(nwritten++);
 	}
-	return result;
+}
+
+bool ElectronJetTreeCreator::Generate() {
+	if(!fEventSource->NextEvent()) return false;
+	fEventWeight = fEventSource->GetWeight();
+	fCrossSection = fEventSource->GetCrossSection();
+	fJetFinder.FindJets(fEventSource->GetEvent());
+	FillJets(fJetFinder.GetJets());
+	return true;
+}
+
+void ElectronJetTreeCreator::FillJets(const std::vector<ElectronJet> &jets) {
+	ReleaseOversizedBuffers();
+	switch(fOutputFormat){
+	case kCompactFormat: ConvertJets(jets, *fCompactElectronJets, fQuantization); break;
+	case kFlatFormat: ConvertJets(jets, *fFlatElectronJets, fQuantization); break;
+	default: ConvertJets(jets, *fElectronJets, fQuantization); break;
+	};
+}
+
+/**
+ * Event source, jet finder and output settings must be applied before
+ * Init: afterwards the source may be wrapped and running in the prefetch
+ * thread, the jet finders are copied into the worker pool and the output
+ * branches are booked.
+ *
+ * @param setting Name of the setting, used in the error message
+ */
+void ElectronJetTreeCreator::CheckNotInitialized(const std::string &setting) const {
+	if(fInitialized)
+		throw std::logic_error(setting + " must be set before ElectronJetTreeCreator::Init");
+}
+
+void ElectronJetTreeCreator::SetEventSource(EventSource *source){
+	CheckNotInitialized("Event source");
+	fEventSource = std::unique_ptr<EventSource>(source);
 }
 
 void ElectronJetTreeCreator::SetPartonID(Generator::Parton_t parton){
-	fGenerator.SetParton(parton);
+	CheckNotInitialized("Parton ID");
+	Generator *partongen = dynamic_cast<Generator *>(fEventSource.get());
+	if(!partongen)
+		throw std::invalid_argument("Parton ID only applies to the parton pair generator");
+	partongen->SetParton(parton);
 }
 
 void ElectronJetTreeCreator::SetMinPtConstituent(double ptcut){
+	CheckNotInitialized("Constituent pt cut");
 	fJetFinder.SetParticlePtCut(ptcut);
 }
 
 void ElectronJetTreeCreator::SetEtaRangeConstituent(double etamin, double etamax){
+	CheckNotInitialized("Constituent eta range");
 	fJetFinder.SetParticleEtaCut(etamin, etamax);
 }
 
 void ElectronJetTreeCreator::SetMinPtLeading(double ptcut){
+	CheckNotInitialized("Leading track pt cut");
 	fJetFinder.SetLeadingTrackPtCut(ptcut);
 }
 void ElectronJetTreeCreator::SetSeed(unsigned long seed){
-	// for simplicity pythia and the pt generator engine get the same seed
-	fGenerator.SetPartonRandomSeed(seed);
-	fGenerator.SetPythiaSeed(seed);
+	CheckNotInitialized("Seed");
+	fEventSource->SetSeed(seed);
 }
 
 void ElectronJetTreeCreator::SetJetR(double r){
+	CheckNotInitialized("Jet radius");
 	fJetFinder.SetJetDefinition(fastjet::JetDefinition(fastjet::antikt_algorithm, r));
 }
 
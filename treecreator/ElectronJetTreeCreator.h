@@ -8,17 +8,30 @@
  */
 
 #include "ElectronJetFinder.h"
+#include "EventSource.h"
 #include "Generator.h"
+#include "JetTreeCompactData.h"
 #include "JetTreeData.h"
+#include "JetTreeFlatData.h"
+#include "JetFinderPool.h"
+#include "MemoryMonitor.h"
+#include <cstddef>
+#include <deque>
 #include <memory>
 #include <string>
 
 
-]class TFile;
+class TFile;
 class TTree;
 
 class ElectronJetTreeCreator {
 public:
+	enum OutputFormat_t {
+		kLegacyFormat,			/// Constituents as double px, py, pz, E and PDG
+		kCompactFormat,			/// Constituents as quantized pt, eta, phi and PDG
+		kFlatFormat				/// Jets and constituents as flat columns
+	};
+
 	ElectronJetTreeCreator();
 	ElectronJetTreeCreator(Generator::Parton_t parton);
 	virtual ~ElectronJetTreeCreator() {}
@@ -30,22 +43,64 @@ public:
 	void SetJetR(double r);
 	void SetOuputFilename(std::string filename) { fOutputFileName = filename; }
 	void SetSeed(unsigned long seed);
+	void SetEventSource(EventSource *source);
+	void SetPrefetchDepth(int depth) { CheckNotInitialized("Prefetch depth"); fPrefetchDepth = depth; }
+	void SetNumberOfClusterThreads(int nthreads) { CheckNotInitialized("Number of cluster threads"); fNClusterThreads = nthreads; }
+	void SetOutputFormat(OutputFormat_t format) { CheckNotInitialized("Output format"); fOutputFormat = format; }
+	void SetQuantization(const JetTreeQuantization &quant) { CheckNotInitialized("Quantization"); fQuantization = quant; }
+	void SetMemoryBudget(size_t maxrss) { fMemoryBudget = maxrss; }
+	void SetBasketMemoryLimit(size_t maxbytes) { fBasketMemoryLimit = maxbytes; }
+	// caps per event (jets) and per jet (constituents)
+	void SetMaxBufferCapacity(size_t maxjets, size_t maxconstituents) {
+		fMaxJetCapacity = maxjets;
+		fMaxConstituentCapacity = maxconstituents;
+	}
+	void SetMemorySamplingInterval(int nevents) { fMemorySamplingInterval = nevents; }
+
+	const MemoryMonitor &GetMemoryMonitor() const { return fMemoryMonitor; }
 
 	void Init();
 	void Process(int nevents = 1000);
 
 protected:
-	void Generate();
-	JetTreeData	ConvertElectronJet(const ElectronJet &inputjet) const;
+	bool Generate();
+	void ProcessParallel(int nevents);
+	void FillJets(const std::vector<ElectronJet> &jets);
+	void ReleaseOversizedBuffers();
+	void EnforceMemoryLimits(int iev);
+	void CheckNotInitialized(const std::string &setting) const;
 
 private:
-	Generator 									fGenerator;
 	ElectronJetFinder							fJetFinder;
+	std::unique_ptr<EventSource>				fEventSource;
+	int											fPrefetchDepth;
+	bool										fInitialized;
+	int											fNClusterThreads;
+	std::unique_ptr<JetFinderPool>				fJetFinderPool;
+	std::vector<ElectronJet>					fClusteredJets;
+	std::deque<double>							fPendingWeights;
 
 	std::string									fOutputFileName;
 	std::unique_ptr<TFile>						fOutputFile;
 	std::unique_ptr<TTree>						fOutputTree;
+	OutputFormat_t								fOutputFormat;
+	JetTreeQuantization							fQuantization;
+	double										fEventWeight;
+	double										fCrossSection;
 	std::unique_ptr<std::vector<JetTreeData> >	fElectronJets;
+	std::unique_ptr<std::vector<JetTreeCompactData> >	fCompactElectronJets;
+	std::unique_ptr<JetTreeFlatData>			fFlatElectronJets;
+
+	size_t										fMemoryBudget;
+	size_t										fBasketMemoryLimit;
+	size_t										fMaxJetCapacity;
+	size_t										fMaxConstituentCapacity;
+	int											fMemorySamplingInterval;
+	bool										fOverMemoryBudget;
+	bool										fBasketsLimited;
+	MemoryMonitor								fMemoryMonitor;
+
+	static const int							kDefaultBudgetCheckInterval = 100;
 };
 
 #endif
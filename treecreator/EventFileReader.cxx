@@ -0,0 +1,145 @@
+/****************************************************************************
+ * Analysis of electrons in jets 							                *
+ * Copyright (C) 2015  Markus Fasel, Lawrence Berkeley National Laboratory  *
+ *                                                                          *
+ * This program is free software: you can redistribute it and/or modify     *
+ * it under the terms of the GNU General Public License as published by     *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful,          *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ * GNU General Public License for more details.                             *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License        *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ ****************************************************************************/
+#include "EventFileReader.h"
+
+#include <iomanip>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+/**
+ * Constructor
+ */
+EventFileReader::EventFileReader() :
+	fInputFileName(),
+	fInputStream(),
+	fPythia(),
+	fEvent(),
+	fWeight(1.)
+{
+}
+
+/**
+ * Constructor, setting the input file
+ *
+ * @param filename Name of the file with the stored events
+ */
+EventFileReader::EventFileReader(const std::string &filename) :
+	fInputFileName(filename),
+	fInputStream(),
+	fPythia(),
+	fEvent(),
+	fWeight(1.)
+{
+}
+
+/**
+ * Destructor
+ */
+EventFileReader::~EventFileReader() {
+}
+
+/**
+ * Open the input file
+ */
+void EventFileReader::Init(){
+	InitEvent();
+	fInputStream.open(fInputFileName.c_str());
+	if(!fInputStream.good())
+		throw std::runtime_error("Cannot open event file " + fInputFileName);
+}
+
+/**
+ * Connect the event to the particle data, which is needed when
+ * particles are appended
+ */
+void EventFileReader::InitEvent(){
+	if(!fPythia.particleData.isParticle(211))
+		throw std::runtime_error("Pythia particle data could not be loaded, check PYTHIA8DATA");
+	fEvent.init("replayed event", &fPythia.particleData);
+}
+
+/**
+ * Read the next event from the file.
+ *
+ * @return True if an event was read, false at end of file
+ */
+bool EventFileReader::NextEvent(){
+	try {
+		return ReadEvent(fInputStream);
+	} catch(std::runtime_error &e) {
+		throw std::runtime_error(std::string(e.what()) + " in " + fInputFileName);
+	}
+}
+
+/**
+ * Read event from stream. Particles are appended without colour
+ * information, which is not needed for jet finding.
+ *
+ * @param in Input stream
+ * @return True if an event was read, false at end of stream
+ */
+bool EventFileReader::ReadEvent(std::istream &in){
+	char tag;
+	if(!(in >> tag)){
+		if(in.eof()) return false;
+		throw std::runtime_error("Unreadable event header");
+	}
+	if(tag != 'E')
+		throw std::runtime_error("Malformed event header");
+	int eventnumber, nparticles;
+	double weight;
+	if(!(in >> eventnumber >> nparticles >> weight))
+		throw std::runtime_error("Truncated event header");
+
+	fEvent.reset();
+	fWeight = weight;
+	int pdg, status;
+	double px, py, pz, e, m;
+	for(int ipart = 0; ipart < nparticles; ipart++){
+		if(!(in >> pdg >> status >> px >> py >> pz >> e >> m))
+			throw std::runtime_error("Truncated event");
+		fEvent.append(pdg, status, 0, 0, px, py, pz, e, m);
+	}
+	return true;
+}
+
+/**
+ * Write event in the format understood by the reader
+ *
+ * @param out Output stream
+ * @param event Event to store
+ * @param eventnumber Event number put in the header
+ * @param weight Event weight put in the header
+ * @param finalonly If true only final state particles are stored
+ */
+void EventFileReader::WriteEvent(std::ostream &out, const Pythia8::Event &event, int eventnumber, double weight, bool finalonly){
+	int nparticles = 0;
+	for(int ipart = 0; ipart < event.size(); ipart++){
+		if(!finalonly || event[ipart].isFinal()) nparticles++;
+	}
+	out << std::setprecision(17);
+	out << "E " << eventnumber << " " << nparticles << " " << weight << "\n";
+	for(int ipart = 0; ipart < event.size(); ipart++){
+		const Pythia8::Particle &mypart = event[ipart];
+		if(finalonly && !mypart.isFinal()) continue;
+		out << mypart.id() << " " << mypart.status() << " "
+			<< mypart.px() << " " << mypart.py() << " " << mypart.pz() << " "
+			<< mypart.e() << " " << mypart.m() << "\n";
+	}
+}
@@ -0,0 +1,59 @@
+#ifndef EVENTFILEREADER_H_
+#define EVENTFILEREADER_H_
+/*
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version. (See cxx source for full Copyright notice)
+ */
+
+#include "EventSource.h"
+
+#include <Pythia8/Event.h>
+#include <Pythia8/Pythia.h>
+#include <fstream>
+#include <iosfwd>
+#include <string>
+
+/**
+ * Event source replaying events stored in a plain text file. Each event
+ * starts with a header line
+ *
+ *   E <event number> <number of particles> <weight>
+ *
+ * followed by one line per particle
+ *
+ *   <PDG code> <status> <px> <py> <pz> <E> <m>
+ *
+ * Files in this format are produced by WriteEvent. Particle properties
+ * are taken from the particle data of an owned pythia instance.
+ */
+class EventFileReader : public EventSource {
+public:
+	EventFileReader();
+	EventFileReader(const std::string &filename);
+	virtual ~EventFileReader();
+
+	virtual void Init();
+	virtual bool NextEvent();
+	virtual const Pythia8::Event	&GetEvent() const { return fEvent; }
+	virtual double GetWeight() const { return fWeight; }
+	virtual void SetSeed(unsigned long) {}
+
+	void SetInputFilename(const std::string &filename) { fInputFileName = filename; }
+
+	static void WriteEvent(std::ostream &out, const Pythia8::Event &event, int eventnumber, double weight = 1., bool finalonly = true);
+
+protected:
+	void InitEvent();
+	bool ReadEvent(std::istream &in);
+
+private:
+	std::string										fInputFileName;					/// Name of the input file
+	std::ifstream									fInputStream;					/// Input stream
+	Pythia8::Pythia									fPythia;						/// Pythia instance providing the particle data
+	Pythia8::Event									fEvent;							/// Current event
+	double											fWeight;						/// Weight of the current event
+};
+
+#endif
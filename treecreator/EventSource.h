@@ -0,0 +1,33 @@
+#ifndef EVENTSOURCE_H_
+#define EVENTSOURCE_H_
+/*
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version. (See cxx source for full Copyright notice)
+ */
+
+#include <Pythia8/Event.h>
+
+/**
+ * Common interface of all sources providing events to the
+ * electron jet tree creator. Sources are initialized once and
+ * then polled with NextEvent() until they report that no further
+ * event is available. Weight and cross section refer to the current
+ * event; sources without weighting use weight 1 and cross section 0.
+ */
+class EventSource {
+public:
+	EventSource() {}
+	virtual ~EventSource() {}
+
+	virtual void Init() = 0;
+	virtual bool NextEvent() = 0;
+	virtual const Pythia8::Event	&GetEvent() const = 0;
+	virtual double GetWeight() const { return 1.; }
+	virtual double GetCrossSection() const { return 0.; }
+
+	virtual void SetSeed(unsigned long seed) = 0;
+};
+
+#endif
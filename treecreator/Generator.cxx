@@ -120,6 +120,17 @@ void Generator::Generate(){
 	fPythia.next();
 }
 
+/**
+ * Event source interface: generate the next parton pair and shower it.
+ * The parton generator never runs out of events.
+ *
+ * @return Always true
+ */
+bool Generator::NextEvent(){
+	Generate();
+	return true;
+}
+
 /**
  * Access to pythia event
  * @return Reference to the PYTHIA event
@@ -128,6 +139,16 @@ const Pythia8::Event &Generator::GetEvent() const {
 	return fPythia.event;
 }
 
+/**
+ * Set the same seed for pythia and the parton pt generation
+ *
+ * @param seed Random seed
+ */
+void Generator::SetSeed(unsigned long seed){
+	SetPartonRandomSeed(seed);
+	SetPythiaSeed(seed);
+}
+
 /**
  * Set the Pythia random seed
  *
@@ -7,11 +7,13 @@
  *  (at your option) any later version. (See cxx source for full Copyright notice)
  */
 
+#include "EventSource.h"
+
 #include <Pythia8/Pythia.h>
 #include <array>
 #include <random>
 
-class Generator {
+class Generator : public EventSource {
 public:
 	enum Parton_t {
 		kGluon  	= 21,
@@ -26,9 +28,12 @@ public:
 	Generator(Parton_t parton);
 	virtual ~Generator();
 
-	void Init();
+	virtual void Init();
+	virtual bool NextEvent();
+	virtual const Pythia8::Event	&GetEvent() const;
+	virtual void SetSeed(unsigned long seed);
+
 	void Generate();
-	const Pythia8::Event			&GetEvent() const;
 
 	void SetParton(Parton_t parton) { fParton = parton; }
 	void SetPtLimits(double mine, double maxe) { fPtLimits[0] = mine; fPtLimits[1] = maxe; }
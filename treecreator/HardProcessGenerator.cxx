@@ -0,0 +1,137 @@
+/****************************************************************************
+ * Analysis of electrons in jets 							                *
+ * Copyright (C) 2015  Markus Fasel, Lawrence Berkeley National Laboratory  *
+ *                                                                          *
+ * This program is free software: you can redistribute it and/or modify     *
+ * it under the terms of the GNU General Public License as published by     *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful,          *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ * GNU General Public License for more details.                             *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License        *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ ****************************************************************************/
+#include "HardProcessGenerator.h"
+
+#include <sstream>
+
+/**
+ * Constructor, by default generating heavy flavour pairs
+ * (HardQCD:hardbbbar) at LHC energy without pt-hat limits
+ */
+HardProcessGenerator::HardProcessGenerator() :
+	fPythia(),
+	fProcess("HardQCD:hardbbbar"),
+	fCMSEnergy(13000.),
+	fPtHatBin(),
+	fMaxFailures(10),
+	fSettings()
+{
+	fPtHatBin[0] = 0; fPtHatBin[1] = -1;
+}
+
+/**
+ * Constructor, setting the hard process
+ *
+ * @param process Pythia process switch, i.e. HardQCD:hardbbbar
+ */
+HardProcessGenerator::HardProcessGenerator(const std::string &process) :
+	fPythia(),
+	fProcess(process),
+	fCMSEnergy(13000.),
+	fPtHatBin(),
+	fMaxFailures(10),
+	fSettings()
+{
+	fPtHatBin[0] = 0; fPtHatBin[1] = -1;
+}
+
+/**
+ * Destructor
+ */
+HardProcessGenerator::~HardProcessGenerator() {
+}
+
+/**
+ * Configure beams, hard process and pt-hat bin and initialize pythia.
+ * Additional settings are applied last and can override the defaults.
+ */
+void HardProcessGenerator::Init(){
+	std::stringstream ecmsstring, processstring, pthatminstring;
+	ecmsstring << "Beams:eCM = " << fCMSEnergy;
+	processstring << fProcess << " = on";
+	pthatminstring << "PhaseSpace:pTHatMin = " << fPtHatBin[0];
+	fPythia.readString("Beams:idA = 2212");
+	fPythia.readString("Beams:idB = 2212");
+	fPythia.readString(ecmsstring.str());
+	fPythia.readString(processstring.str());
+	fPythia.readString(pthatminstring.str());
+	if(fPtHatBin[1] > 0){
+		std::stringstream pthatmaxstring;
+		pthatmaxstring << "PhaseSpace:pTHatMax = " << fPtHatBin[1];
+		fPythia.readString(pthatmaxstring.str());
+	}
+	fPythia.readString("Next:numberShowInfo = 0");
+	fPythia.readString("Next:numberShowProcess = 0");
+	fPythia.readString("Next:numberShowEvent = 0");
+	for(auto setting : fSettings) fPythia.readString(setting);
+
+	fPythia.init();
+}
+
+/**
+ * Generate the next event. Failed events are retried up to the
+ * maximum number of failures in a row.
+ *
+ * @return True if an event was generated, false if pythia gave up
+ */
+bool HardProcessGenerator::NextEvent(){
+	for(int itry = 0; itry < fMaxFailures; itry++){
+		if(fPythia.next()) return true;
+		if(fPythia.info.atEndOfFile()) break;
+	}
+	return false;
+}
+
+/**
+ * Access to pythia event
+ * @return Reference to the PYTHIA event
+ */
+const Pythia8::Event &HardProcessGenerator::GetEvent() const {
+	return fPythia.event;
+}
+
+/**
+ * Set the Pythia random seed
+ *
+ * @param seed new random seed
+ */
+void HardProcessGenerator::SetSeed(unsigned long seed){
+	fPythia.readString("Random:setSeed = on");
+	std::stringstream seedstring;
+	seedstring << "Random:seed = " << seed;
+	fPythia.readString(seedstring.str());
+}
+
+/**
+ * Event weight of the current event
+ *
+ * @return Pythia event weight
+ */
+double HardProcessGenerator::GetWeight() const {
+	return fPythia.info.weight();
+}
+
+/**
+ * Cross section estimate of the pt-hat bin, to be used to combine
+ * several pt-hat bins
+ *
+ * @return Generated cross section in mb
+ */
+double HardProcessGenerator::GetCrossSection() const {
+	return fPythia.info.sigmaGen();
+}
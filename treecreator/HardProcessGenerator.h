@@ -0,0 +1,52 @@
+#ifndef HARDPROCESSGENERATOR_H_
+#define HARDPROCESSGENERATOR_H_
+/*
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version. (See cxx source for full Copyright notice)
+ */
+
+#include "EventSource.h"
+
+#include <Pythia8/Pythia.h>
+#include <array>
+#include <string>
+#include <vector>
+
+/**
+ * Event source running the full pythia machinery (beams, hard process,
+ * showers, hadronisation) for a selected set of hard processes in a
+ * single pt-hat bin.
+ */
+class HardProcessGenerator : public EventSource {
+public:
+	HardProcessGenerator();
+	HardProcessGenerator(const std::string &process);
+	virtual ~HardProcessGenerator();
+
+	virtual void Init();
+	virtual bool NextEvent();
+	virtual const Pythia8::Event	&GetEvent() const;
+	virtual void SetSeed(unsigned long seed);
+
+	void SetProcess(const std::string &process) { fProcess = process; }
+	void SetCMSEnergy(double ecms) { fCMSEnergy = ecms; }
+	void SetPtHatBin(double minpthat, double maxpthat) { fPtHatBin[0] = minpthat; fPtHatBin[1] = maxpthat; }
+	void SetMaxFailures(int nfailures) { fMaxFailures = nfailures; }
+	void AddSetting(const std::string &setting) { fSettings.push_back(setting); }
+
+	virtual double GetWeight() const;
+	virtual double GetCrossSection() const;
+
+private:
+	Pythia8::Pythia									fPythia;						/// Pythia engine
+
+	std::string										fProcess;						/// Pythia process switch (i.e. HardQCD:hardbbbar)
+	double											fCMSEnergy;						/// Center-of-mass energy in GeV
+	std::array<double, 2>							fPtHatBin;						/// Pt-hat limits, max < 0 means open
+	int												fMaxFailures;					/// Number of failed pythia calls in a row before giving up
+	std::vector<std::string>						fSettings;						/// Additional pythia settings
+};
+
+#endif
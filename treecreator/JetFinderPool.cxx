@@ -0,0 +1,169 @@
+/****************************************************************************
+ * Analysis of electrons in jets 							                *
+ * Copyright (C) 2015  Markus Fasel, Lawrence Berkeley National Laboratory  *
+ *                                                                          *
+ * This program is free software: you can redistribute it and/or modify     *
+ * it under the terms of the GNU General Public License as published by     *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful,          *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ * GNU General Public License for more details.                             *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License        *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ ****************************************************************************/
+#include "JetFinderPool.h"
+
+#include <fastjet/ClusterSequence.hh>
+
+/**
+ * Constructor, starting the worker threads
+ *
+ * @param prototype Configured jet finder copied for each worker
+ * @param nworkers Number of worker threads
+ * @param maxinflight Max. number of events submitted ahead of delivery (default: 2 per worker)
+ */
+JetFinderPool::JetFinderPool(const ElectronJetFinder &prototype, int nworkers, int maxinflight) :
+	fFinders(),
+	fWorkers(),
+	fMaxInFlight(),
+	fNextSubmit(0),
+	fNextDeliver(0),
+	fTasks(),
+	fResults(),
+	fStop(false),
+	fMutex(),
+	fTaskCondition(),
+	fResultCondition()
+{
+	if(nworkers < 1) nworkers = 1;
+	fMaxInFlight = maxinflight > 0 ? maxinflight : 2 * nworkers;
+	fFinders.assign(nworkers, prototype);
+	// initialize the FastJet statics (banner) in this thread before the workers start
+	fastjet::ClusterSequence warmup(std::vector<fastjet::PseudoJet>(1, fastjet::PseudoJet(1., 0., 0., 1.)), prototype.GetJetDefinition());
+	for(int iworker = 0; iworker < nworkers; iworker++)
+		fWorkers.push_back(std::thread(&JetFinderPool::Work, this, iworker));
+}
+
+/**
+ * Destructor, stops the worker threads
+ */
+JetFinderPool::~JetFinderPool() {
+	Stop();
+}
+
+/**
+ * Check whether another event can be submitted without exceeding
+ * the in-flight limit
+ */
+bool JetFinderPool::CanSubmit() const {
+	std::lock_guard<std::mutex> lock(fMutex);
+	return fNextSubmit - fNextDeliver < fMaxInFlight;
+}
+
+/**
+ * Queue event for clustering
+ *
+ * @param snapshot Final state particles of the event
+ */
+void JetFinderPool::Submit(Snapshot_t snapshot){
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+		fTasks.push_back(std::make_pair(fNextSubmit++, snapshot));
+	}
+	fTaskCondition.notify_one();
+}
+
+/**
+ * Get the jets of the next event in submission order, waiting
+ * until the event is clustered. An exception thrown while clustering
+ * the event is rethrown here.
+ *
+ * @param jets Output container for the jets
+ * @return False if no event is pending
+ */
+bool JetFinderPool::NextResult(std::vector<ElectronJet> &jets){
+	std::unique_lock<std::mutex> lock(fMutex);
+	if(fNextSubmit == fNextDeliver) return false;
+	fResultCondition.wait(lock, [this]{ return fResults.count(fNextDeliver) > 0; });
+	auto found = fResults.find(fNextDeliver);
+	std::exception_ptr error = found->second.fError;
+	jets.swap(found->second.fJets);
+	fResults.erase(found);
+	fNextDeliver++;
+	if(error) std::rethrow_exception(error);
+	return true;
+}
+
+/**
+ * Copy the final state particles of the event into an immutable snapshot.
+ * Only PDG code, status and kinematics are copied into new particles, which
+ * have no pointer back into the generator event: that event is overwritten
+ * while the snapshot is clustered, so history information (mothers,
+ * daughters) is not available for snapshot particles.
+ *
+ * @param event Input event
+ * @return Shared snapshot of the final state
+ */
+JetFinderPool::Snapshot_t JetFinderPool::MakeSnapshot(const Pythia8::Event &event){
+	std::shared_ptr<std::vector<Pythia8::Particle> > snapshot(new std::vector<Pythia8::Particle>);
+	snapshot->reserve(event.size());
+	for(int ipart = 0; ipart < event.size(); ipart++){
+		const Pythia8::Particle &mypart = event[ipart];
+		if(!mypart.isFinal()) continue;
+		snapshot->push_back(Pythia8::Particle(mypart.id(), mypart.status(), 0, 0, 0, 0, 0, 0,
+				mypart.px(), mypart.py(), mypart.pz(), mypart.e(), mypart.m()));
+	}
+	return snapshot;
+}
+
+/**
+ * Worker loop: cluster queued events with the worker's own jet finder
+ *
+ * @param iworker Index of the worker
+ */
+void JetFinderPool::Work(int iworker){
+	ElectronJetFinder &finder = fFinders[iworker];
+	while(true){
+		std::pair<long, Snapshot_t> task;
+		{
+			std::unique_lock<std::mutex> lock(fMutex);
+			fTaskCondition.wait(lock, [this]{ return fStop || !fTasks.empty(); });
+			if(fStop) return;
+			task = fTasks.front();
+			fTasks.pop_front();
+		}
+		std::vector<ElectronJet> jets;
+		std::exception_ptr error;
+		try {
+			finder.FindJets(*task.second);
+			finder.TakeJets(jets);
+		} catch(...) {
+			error = std::current_exception();
+		}
+		{
+			std::lock_guard<std::mutex> lock(fMutex);
+			Result_t &result = fResults[task.first];
+			result.fJets.swap(jets);
+			result.fError = error;
+		}
+		fResultCondition.notify_all();
+	}
+}
+
+/**
+ * Stop the workers and wait for them to finish
+ */
+void JetFinderPool::Stop(){
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+		fStop = true;
+	}
+	fTaskCondition.notify_all();
+	for(auto &worker : fWorkers){
+		if(worker.joinable()) worker.join();
+	}
+}
@@ -0,0 +1,75 @@
+#ifndef JETFINDERPOOL_H_
+#define JETFINDERPOOL_H_
+/*
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version. (See cxx source for full Copyright notice)
+ */
+
+#include "ElectronJetFinder.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <Pythia8/Event.h>
+
+/**
+ * Pool of worker threads, each running its own copy of an electron
+ * jet finder. Events are submitted as immutable snapshots of their final
+ * state particles, so the generator can continue with the next event
+ * while previous ones are clustered. Results are handed out in the
+ * order in which the events were submitted. Exceptions thrown while
+ * clustering an event are rethrown when that event is due.
+ *
+ * Clustering in several threads requires FastJet >= 3.4 configured with
+ * --enable-thread-safety, older versions update warning counters without
+ * synchronisation.
+ */
+class JetFinderPool {
+public:
+	typedef std::shared_ptr<const std::vector<Pythia8::Particle> > Snapshot_t;
+
+	JetFinderPool(const ElectronJetFinder &prototype, int nworkers, int maxinflight = 0);
+	~JetFinderPool();
+
+	bool CanSubmit() const;
+	void Submit(Snapshot_t snapshot);
+	bool NextResult(std::vector<ElectronJet> &jets);
+
+	static Snapshot_t MakeSnapshot(const Pythia8::Event &event);
+
+protected:
+	struct Result_t {
+		std::vector<ElectronJet>							fJets;
+		std::exception_ptr									fError;
+	};
+
+	void Work(int iworker);
+	void Stop();
+
+private:
+	JetFinderPool(const JetFinderPool &);
+	JetFinderPool &operator=(const JetFinderPool &);
+
+	std::vector<ElectronJetFinder>							fFinders;				/// One jet finder per worker
+	std::vector<std::thread>								fWorkers;				/// Worker threads
+	int														fMaxInFlight;			/// Max. number of submitted but not yet delivered events
+	long													fNextSubmit;			/// Sequence number of the next submitted event
+	long													fNextDeliver;			/// Sequence number of the next delivered event
+	std::deque<std::pair<long, Snapshot_t> >				fTasks;					/// Events waiting for clustering
+	std::map<long, Result_t>								fResults;				/// Clustered events not yet delivered
+	bool													fStop;					/// Request to stop the workers
+	mutable std::mutex										fMutex;					/// Protects queues and counters
+	std::condition_variable									fTaskCondition;			/// Signals new tasks
+	std::condition_variable									fResultCondition;		/// Signals new results
+};
+
+#endif
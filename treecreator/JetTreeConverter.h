@@ -0,0 +1,83 @@
+#ifndef JETTREECONVERTER_H_
+#define JETTREECONVERTER_H_
+/*
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version. (See cxx source for full Copyright notice)
+ */
+
+#include "ElectronJetFinder.h"
+#include "JetTreeCompactData.h"
+#include "JetTreeData.h"
+#include "JetTreeFlatData.h"
+
+#include <vector>
+
+/**
+ * Conversion from electron jets into output records of a given schema.
+ * Records are filled in place: the output container is resized to the
+ * number of jets and existing records (and their constituent buffers)
+ * are reused, so no temporaries are created per jet or constituent.
+ *
+ * Each record type provides its own specialization of JetRecordFiller.
+ */
+template<typename Record_t>
+struct JetRecordFiller;
+
+template<>
+struct JetRecordFiller<JetTreeData> {
+	static inline void Fill(JetTreeData &record, const ElectronJet &jet, const JetTreeQuantization &){
+		const fastjet::PseudoJet &jetvec = jet.GetPseudoJet();
+		const std::vector<Pythia8::Particle> &particles = jet.GetParticles();
+		record.Set(jetvec.px(), jetvec.py(), jetvec.pz(), jetvec.E());
+		record.ResizeConstituents(particles.size());
+		for(size_t iconst = 0; iconst < particles.size(); iconst++){
+			const Pythia8::Particle &mypart = particles[iconst];
+			record.GetConstituent(iconst).Set(mypart.px(), mypart.py(), mypart.pz(), mypart.e(), mypart.id());
+		}
+	}
+};
+
+template<>
+struct JetRecordFiller<JetTreeCompactData> {
+	static inline void Fill(JetTreeCompactData &record, const ElectronJet &jet, const JetTreeQuantization &quant){
+		const fastjet::PseudoJet &jetvec = jet.GetPseudoJet();
+		const std::vector<Pythia8::Particle> &particles = jet.GetParticles();
+		record.Set(jetvec.px(), jetvec.py(), jetvec.pz(), jetvec.E());
+		record.ResizeConstituents(particles.size());
+		for(size_t iconst = 0; iconst < particles.size(); iconst++){
+			const Pythia8::Particle &mypart = particles[iconst];
+			record.GetConstituent(iconst).SetFromPxPyPzE(mypart.px(), mypart.py(), mypart.pz(), mypart.e(), mypart.id(), quant);
+		}
+	}
+};
+
+/**
+ * Convert jets into one record per jet
+ */
+template<typename Record_t>
+inline void ConvertJets(const std::vector<ElectronJet> &jets, std::vector<Record_t> &output, const JetTreeQuantization &quant){
+	output.resize(jets.size());
+	for(size_t ijet = 0; ijet < jets.size(); ijet++)
+		JetRecordFiller<Record_t>::Fill(output[ijet], jets[ijet], quant);
+}
+
+/**
+ * Convert jets into flat columns, sized once for all jets of the event
+ */
+inline void ConvertJets(const std::vector<ElectronJet> &jets, JetTreeFlatData &output, const JetTreeQuantization &){
+	size_t nconstituents = 0;
+	for(const auto &jet : jets) nconstituents += jet.GetParticles().size();
+	output.Resize(jets.size(), nconstituents);
+	size_t iconst = 0;
+	for(size_t ijet = 0; ijet < jets.size(); ijet++){
+		const fastjet::PseudoJet &jetvec = jets[ijet].GetPseudoJet();
+		const std::vector<Pythia8::Particle> &particles = jets[ijet].GetParticles();
+		output.SetJet(ijet, jetvec.px(), jetvec.py(), jetvec.pz(), jetvec.E(), particles.size());
+		for(const auto &mypart : particles)
+			output.SetConstituent(iconst++, mypart.px(), mypart.py(), mypart.pz(), mypart.e(), mypart.id());
+	}
+}
+
+#endif
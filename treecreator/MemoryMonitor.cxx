@@ -0,0 +1,79 @@
+/****************************************************************************
+ * Analysis of electrons in jets 							                *
+ * Copyright (C) 2015  Markus Fasel, Lawrence Berkeley National Laboratory  *
+ *                                                                          *
+ * This program is free software: you can redistribute it and/or modify     *
+ * it under the terms of the GNU General Public License as published by     *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful,          *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ * GNU General Public License for more details.                             *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License        *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ ****************************************************************************/
+#include "MemoryMonitor.h"
+
+#include <fstream>
+#include <ostream>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+/**
+ * Constructor
+ */
+MemoryMonitor::MemoryMonitor() :
+	fCurrentRSS(0),
+	fPeakRSS(0),
+	fNSamples(0)
+{
+}
+
+/**
+ * Update current and peak RSS
+ */
+void MemoryMonitor::Sample(){
+	fCurrentRSS = ReadCurrentRSS();
+	size_t peak = ReadPeakRSS();
+	if(peak < fCurrentRSS) peak = fCurrentRSS;
+	if(peak > fPeakRSS) fPeakRSS = peak;
+	fNSamples++;
+}
+
+/**
+ * Print summary of the memory usage
+ *
+ * @param out Output stream
+ */
+void MemoryMonitor::Print(std::ostream &out) const {
+	out << "Memory usage: current RSS " << (fCurrentRSS >> 20) << " MB, peak RSS "
+		<< (fPeakRSS >> 20) << " MB (" << fNSamples << " samples)" << std::endl;
+}
+
+/**
+ * Read the current resident set size from /proc/self/statm
+ *
+ * @return Current RSS in bytes, 0 if not available
+ */
+size_t MemoryMonitor::ReadCurrentRSS(){
+	std::ifstream statm("/proc/self/statm");
+	size_t vsize = 0, rsspages = 0;
+	if(!(statm >> vsize >> rsspages)) return 0;
+	return rsspages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+/**
+ * Read the peak resident set size as reported by the kernel
+ *
+ * @return Peak RSS in bytes
+ */
+size_t MemoryMonitor::ReadPeakRSS(){
+	struct rusage usage;
+	if(getrusage(RUSAGE_SELF, &usage)) return 0;
+	// ru_maxrss is given in kB on Linux
+	return static_cast<size_t>(usage.ru_maxrss) * 1024;
+}
@@ -0,0 +1,38 @@
+#ifndef MEMORYMONITOR_H_
+#define MEMORYMONITOR_H_
+/*
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version. (See cxx source for full Copyright notice)
+ */
+
+#include <cstddef>
+#include <iosfwd>
+
+/**
+ * Samples the resident set size of the running process and keeps
+ * track of the current and peak values.
+ */
+class MemoryMonitor {
+public:
+	MemoryMonitor();
+	~MemoryMonitor() {}
+
+	void Sample();
+	void Print(std::ostream &out) const;
+
+	size_t GetCurrentRSS() const { return fCurrentRSS; }
+	size_t GetPeakRSS() const { return fPeakRSS; }
+	int GetNumberOfSamples() const { return fNSamples; }
+
+	static size_t ReadCurrentRSS();
+	static size_t ReadPeakRSS();
+
+private:
+	size_t											fCurrentRSS;					/// RSS at the last sample, in bytes
+	size_t											fPeakRSS;						/// Peak RSS of the process, in bytes
+	int												fNSamples;						/// Number of samples taken
+};
+
+#endif
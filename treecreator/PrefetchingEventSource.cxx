@@ -0,0 +1,130 @@
+/****************************************************************************
+ * Analysis of electrons in jets 							                *
+ * Copyright (C) 2015  Markus Fasel, Lawrence Berkeley National Laboratory  *
+ *                                                                          *
+ * This program is free software: you can redistribute it and/or modify     *
+ * it under the terms of the GNU General Public License as published by     *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful,          *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ * GNU General Public License for more details.                             *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License        *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ ****************************************************************************/
+#include "PrefetchingEventSource.h"
+
+#include <stdexcept>
+
+/**
+ * Constructor
+ *
+ * @param source Underlying event source, ownership is taken over
+ * @param depth Max. number of events read ahead
+ */
+PrefetchingEventSource::PrefetchingEventSource(EventSource *source, int depth) :
+	fSource(source),
+	fDepth(depth > 0 ? depth : 1),
+	fBuffer(),
+	fCurrent(),
+	fSourceDone(false),
+	fStop(false),
+	fError(),
+	fMutex(),
+	fCondition(),
+	fThread()
+{
+}
+
+/**
+ * Destructor, stops the prefetch thread
+ */
+PrefetchingEventSource::~PrefetchingEventSource() {
+	Stop();
+}
+
+/**
+ * Initialize the underlying source and start reading ahead. The
+ * underlying source is only accessed from the prefetch thread afterwards.
+ */
+void PrefetchingEventSource::Init(){
+	fSource->Init();
+	fThread = std::thread(&PrefetchingEventSource::Prefetch, this);
+}
+
+/**
+ * Forward the seed to the underlying source. Only possible before Init,
+ * afterwards the source is used by the prefetch thread.
+ *
+ * @param seed Random seed
+ */
+void PrefetchingEventSource::SetSeed(unsigned long seed){
+	if(fThread.joinable())
+		throw std::logic_error("Seed must be set before the prefetch thread is started");
+	fSource->SetSeed(seed);
+}
+
+/**
+ * Take the next event from the buffer, waiting for the prefetch thread
+ * if necessary. Exceptions thrown by the underlying source are rethrown
+ * here once all events read before are consumed.
+ *
+ * @return True if an event is available, false if the underlying source is exhausted
+ */
+bool PrefetchingEventSource::NextEvent(){
+	std::unique_lock<std::mutex> lock(fMutex);
+	fCondition.wait(lock, [this]{ return !fBuffer.empty() || fSourceDone; });
+	if(fBuffer.empty()){
+		if(fError) std::rethrow_exception(fError);
+		return false;
+	}
+	std::swap(fCurrent, fBuffer.front());
+	fBuffer.pop_front();
+	fCondition.notify_all();
+	return true;
+}
+
+/**
+ * Prefetch loop: produce events as long as the buffer is not full
+ */
+void PrefetchingEventSource::Prefetch(){
+	while(true){
+		{
+			std::unique_lock<std::mutex> lock(fMutex);
+			fCondition.wait(lock, [this]{ return fStop || static_cast<int>(fBuffer.size()) < fDepth; });
+			if(fStop) return;
+		}
+		bool hasevent = false;
+		std::exception_ptr error;
+		try {
+			hasevent = fSource->NextEvent();
+		} catch(...) {
+			error = std::current_exception();
+		}
+		std::lock_guard<std::mutex> lock(fMutex);
+		if(!hasevent){
+			fError = error;
+			fSourceDone = true;
+			fCondition.notify_all();
+			return;
+		}
+		PrefetchedEvent prefetched = {fSource->GetEvent(), fSource->GetWeight(), fSource->GetCrossSection()};
+		fBuffer.push_back(prefetched);
+		fCondition.notify_all();
+	}
+}
+
+/**
+ * Stop the prefetch thread and wait for it to finish
+ */
+void PrefetchingEventSource::Stop(){
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+		fStop = true;
+	}
+	fCondition.notify_all();
+	if(fThread.joinable()) fThread.join();
+}
@@ -0,0 +1,63 @@
+#ifndef PREFETCHINGEVENTSOURCE_H_
+#define PREFETCHINGEVENTSOURCE_H_
+/*
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version. (See cxx source for full Copyright notice)
+ */
+
+#include "EventSource.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/**
+ * Event source wrapping another source and reading ahead from it in a
+ * background thread. Up to a configurable number of events are buffered
+ * as copies together with their weight and cross section, so the
+ * consumer can work on the current event while the next ones are being
+ * produced.
+ */
+class PrefetchingEventSource : public EventSource {
+public:
+	PrefetchingEventSource(EventSource *source, int depth = 4);
+	virtual ~PrefetchingEventSource();
+
+	virtual void Init();
+	virtual bool NextEvent();
+	virtual const Pythia8::Event	&GetEvent() const { return fCurrent.fEvent; }
+	virtual double GetWeight() const { return fCurrent.fWeight; }
+	virtual double GetCrossSection() const { return fCurrent.fCrossSection; }
+	virtual void SetSeed(unsigned long seed);
+
+	EventSource *GetSource() const { return fSource.get(); }
+
+protected:
+	struct PrefetchedEvent {
+		Pythia8::Event								fEvent;
+		double										fWeight;
+		double										fCrossSection;
+	};
+
+	void Prefetch();
+	void Stop();
+
+private:
+	std::unique_ptr<EventSource>					fSource;						/// Underlying source, owned
+	int												fDepth;							/// Max. number of buffered events
+	std::deque<PrefetchedEvent>						fBuffer;						/// Prefetched events
+	PrefetchedEvent									fCurrent;						/// Event handed out to the consumer
+	bool											fSourceDone;					/// Underlying source exhausted
+	bool											fStop;							/// Request to stop the prefetch thread
+	std::exception_ptr								fError;							/// Exception thrown by the underlying source
+	std::mutex										fMutex;							/// Protects buffer and flags
+	std::condition_variable							fCondition;						/// Signals buffer changes
+	std::thread										fThread;						/// Prefetch thread
+};
+
+#endif